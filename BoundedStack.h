@@ -0,0 +1,173 @@
+#ifndef BOUNDED_STACK_H
+#define BOUNDED_STACK_H
+
+
+#include <cstddef>
+#include <type_traits>
+
+/**
+  @brief BoundedStack<T>
+
+  Classe che implementa uno stack di elementi generici T su una memoria fornita dal chiamante,
+  pensata per thread real-time (audio, controllo).
+  La classe non alloca memoria, non lancia eccezioni e non crea oggetti temporanei:
+  push e pop hanno costo O(1) nel caso peggiore e segnalano gli errori tramite valore di ritorno.
+  La memoria rimane di proprietà del chiamante e deve sopravvivere allo stack.
+*/
+template <typename T>
+class BoundedStack {
+
+  static_assert(std::is_nothrow_copy_assignable<T>::value,
+                "BoundedStack<T> richiede un tipo T con assegnamento per copia noexcept");
+
+public:
+
+  typedef unsigned int size_type;
+
+  /**
+    Costruttore della classe BoundedStack<T> a partire da una memoria già allocata.
+    Gli elementi presenti nella memoria non vengono modificati fino al primo push.
+
+    @param puntatore alla memoria da utilizzare come stack
+    @param numero di elementi contenuti nella memoria
+
+    @post _stack_size = numero di elementi contenuti nella memoria
+    @post _current_size = 0
+  */
+  BoundedStack(T *storage, const size_type capacity) noexcept
+    : _stack_size(storage != nullptr ? capacity : 0), _current_size(0), _stack(storage) {}
+
+  /**
+    Costruttore della classe BoundedStack<T> a partire da un array di dimensione nota.
+
+    @param reference all'array da utilizzare come stack
+
+    @post _stack_size = N
+    @post _current_size = 0
+  */
+  template <size_type N>
+  explicit BoundedStack(T (&storage)[N]) noexcept : _stack_size(N), _current_size(0), _stack(storage) {}
+
+  //Lo stack non possiede la memoria: la copia produrrebbe due stack sulla stessa memoria.
+  BoundedStack(const BoundedStack &other) = delete;
+  BoundedStack& operator=(const BoundedStack &other) = delete;
+
+  /**
+    Metodo per il ritorno del numero di elementi attualmente nella struttura dati.
+
+    @return numero di elementi contenuti nella struttura dati
+  */
+  size_type current_stack_size() const noexcept {
+    return _current_size;
+  }
+
+  /**
+    Metodo per il ritorno della dimensione della struttura dati.
+
+    @return dimensione della struttura dati
+  */
+  size_type size() const noexcept {
+    return _stack_size;
+  }
+
+  /**
+    Metodo per verificare se lo stack è vuoto.
+
+    @return true se lo stack non contiene elementi, false altrimenti
+  */
+  bool empty() const noexcept {
+    return _current_size == 0;
+  }
+
+  /**
+    Metodo per verificare se lo stack è pieno.
+
+    @return true se lo stack ha raggiunto la sua dimensione, false altrimenti
+  */
+  bool full() const noexcept {
+    return _current_size == _stack_size;
+  }
+
+  /**
+    Metodo per l'inserimento in cima allo stack di un nuovo elemento.
+    L'elemento viene assegnato direttamente nella sua posizione, senza copie intermedie.
+
+    @param reference all'oggetto da inserire
+    @return true se l'elemento è stato inserito, false se lo stack è pieno
+  */
+  bool push(const T &element) noexcept {
+    if(_current_size == _stack_size){
+      return false;
+    }
+    _stack[_current_size] = element;
+    ++_current_size;
+    return true;
+  }
+
+  /**
+    Metodo per prelevare l'elemento in cima dello stack.
+    Prelevare l'elemento comporta la sua eliminazione dallo stack.
+
+    @param reference all'oggetto in cui copiare l'elemento prelevato
+    @return true se l'elemento è stato prelevato, false se lo stack è vuoto
+  */
+  bool pop(T &element) noexcept {
+    if(_current_size == 0){
+      return false;
+    }
+    --_current_size;
+    element = _stack[_current_size];
+    return true;
+  }
+
+  /**
+    Metodo per eliminare l'elemento in cima dello stack senza copiarlo.
+
+    @return true se l'elemento è stato eliminato, false se lo stack è vuoto
+  */
+  bool pop() noexcept {
+    if(_current_size == 0){
+      return false;
+    }
+    --_current_size;
+    return true;
+  }
+
+  /**
+    Metodo per accedere all'elemento in cima dello stack senza prelevarlo.
+
+    @return puntatore costante all'elemento in cima, nullptr se lo stack è vuoto
+  */
+  const T* top() const noexcept {
+    if(_current_size == 0){
+      return nullptr;
+    }
+    return _stack + (_current_size - 1);
+  }
+
+  /**
+    Metodo per accedere alla memoria su cui lavora lo stack, a partire dal fondo.
+
+    @return puntatore alla memoria fornita dal chiamante
+  */
+  T* data() noexcept {
+    return _stack;
+  }
+
+  /**
+    Metodo per svuotare lo stack.
+
+    @post _current_size = 0
+  */
+  void flush() noexcept {
+    _current_size = 0;
+  }
+
+private:
+
+  size_type _stack_size;
+  size_type _current_size;
+  T* _stack;
+  };
+
+#endif
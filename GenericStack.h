@@ -5,6 +5,18 @@
 #include <ostream>  
 #include <cassert>
 #include <stdexcept>     
+#include <string>
+#include <string_view>
+#include <charconv>
+#include <locale>
+#include <algorithm>
+#include <type_traits>
+#if __has_include(<version>)
+#include <version>
+#endif
+#if defined(__cpp_lib_format)
+#include <format>
+#endif
 
 /**
   @brief GenericStack<T>
@@ -374,6 +386,56 @@ public:
     
   };
 
+  /**
+    Metodo per la scrittura in blocco del contenuto dello stack su uno stream di output,
+    dalla cima al fondo.
+    A differenza dell'operatore di stream, gli elementi vengono formattati in un buffer
+    e scritti sullo stream a blocchi. I tipi aritmetici sono formattati tramite std::to_chars
+    (i floating point nella rappresentazione più breve che ne consente la rilettura esatta),
+    i tipi char come singolo carattere, gli altri tipi tramite il loro operatore di stream.
+    Questa versione utilizza un buffer di 4 KiB sullo stack e non alloca memoria.
+
+    @param lo stream di output
+    @param separatore scritto tra due elementi consecutivi
+    @param terminatore scritto dopo l'ultimo elemento
+    @param true se al termine si vuole eseguire il flush dello stream, false altrimenti
+  */
+  void write_to(std::ostream &os, const std::string_view separator = " ",
+                const std::string_view terminator = "\n", const bool flush_stream = false) const {
+    char buffer[_local_buffer_size];
+    _write(os, buffer, buffer + _local_buffer_size, separator, false, terminator, -1);
+    if(flush_stream){
+      os.flush();
+    }
+  }
+
+  /**
+    Versione di write_to con un buffer fornito dal chiamante, riutilizzabile tra più chiamate
+    così da non riallocarlo. Il buffer viene dimensionato al minimo tra 64 KiB e lo spazio
+    richiesto dagli elementi dello stack.
+
+    @param lo stream di output
+    @param separatore scritto tra due elementi consecutivi
+    @param terminatore scritto dopo l'ultimo elemento
+    @param true se al termine si vuole eseguire il flush dello stream, false altrimenti
+    @param buffer di appoggio, al termine della chiamata è vuoto ma ne conserva la capacità
+  */
+  void write_to(std::ostream &os, const std::string_view separator, const std::string_view terminator,
+                const bool flush_stream, std::string &buffer) const {
+    //Dimensione massima dei blocchi scritti sullo stream
+    const std::size_t chunk_size = 64 * 1024;
+    const std::size_t needed = static_cast<std::size_t>(_current_size)
+                               * (_max_element_chars + separator.size());
+
+    buffer.resize(_max_element_chars + std::min(chunk_size, needed));
+    char *const first = &buffer[0];
+    _write(os, first, first + buffer.size(), separator, false, terminator, -1);
+    buffer.clear();
+    if(flush_stream){
+      os.flush();
+    }
+  }
+
   //Ritorna un iteratore che punta alla cima dello stack
   const_iterator begin() const {
     return const_iterator((_stack + _current_size), _current_size);
@@ -386,6 +448,87 @@ public:
 
 private:
 
+  //Spazio riservato nel buffer per la rappresentazione di un singolo elemento aritmetico
+  static constexpr std::size_t _max_element_chars = 64;
+
+  //Dimensione del buffer locale usato quando il chiamante non ne fornisce uno
+  static constexpr std::size_t _local_buffer_size = 4096;
+
+  /**
+    Scrive gli elementi dalla cima al fondo dello stack, formattandoli direttamente nel buffer
+    [first, last) e scaricandolo sullo stream quando è pieno.
+    Il buffer deve contenere almeno _max_element_chars caratteri.
+    Con precision < 0 i floating point sono scritti nella rappresentazione più breve che ne
+    consente la rilettura esatta, altrimenti come l'operatore di stream (formato %g).
+  */
+  void _write(std::ostream &os, char *const first, char *const last, const std::string_view separator,
+              const bool trailing_separator, const std::string_view terminator, const int precision) const {
+    //Oltre questa posizione un elemento potrebbe non entrare nel buffer
+    char *const limit = last - _max_element_chars;
+    const std::size_t separator_length = separator.size();
+    char *pos = first;
+
+    for(size_type i = _current_size; i > 0; --i){
+      if(pos > limit){
+        os.write(first, pos - first);
+        pos = first;
+      }
+      if constexpr (std::is_arithmetic<T>::value){
+        pos = _format_element(pos, _stack[i], precision);
+      }else{
+        //Tipi senza conversione dedicata: il buffer viene scaricato per mantenere l'ordine
+        os.write(first, pos - first);
+        pos = first;
+        os << _stack[i];
+      }
+      if(i > 1 || trailing_separator){
+        if(separator_length > static_cast<std::size_t>(last - pos)){
+          os.write(first, pos - first);
+          pos = first;
+        }
+        if(separator_length == 1){
+          *pos++ = separator[0];
+        }else if(separator_length <= static_cast<std::size_t>(last - first)){
+          std::char_traits<char>::copy(pos, separator.data(), separator_length);
+          pos += separator_length;
+        }else{
+          //Separatore più grande dell'intero buffer
+          os.write(separator.data(), separator_length);
+        }
+      }
+    }
+    os.write(first, pos - first);
+    os.write(terminator.data(), terminator.size());
+  }
+
+  //Formatta un elemento aritmetico a partire da pos, ritorna la posizione successiva
+  static char* _format_element(char *pos, const T &element, const int precision) {
+    if constexpr (std::is_same<T, char>::value || std::is_same<T, signed char>::value
+                  || std::is_same<T, unsigned char>::value){
+      *pos = static_cast<char>(element);
+      return pos + 1;
+    }else if constexpr (std::is_same<T, bool>::value){
+      *pos = (element ? '1' : '0');
+      return pos + 1;
+    }else if constexpr (std::is_floating_point<T>::value){
+      if(precision < 0){
+        return std::to_chars(pos, pos + _max_element_chars, element).ptr;
+      }
+      return std::to_chars(pos, pos + _max_element_chars, element,
+                           std::chars_format::general, precision).ptr;
+    }else{
+      return std::to_chars(pos, pos + _max_element_chars, element).ptr;
+    }
+  }
+
+  template <typename U>
+  friend std::ostream &operator<<(std::ostream &os, const GenericStack<U> &stack);
+
+#if defined(__cpp_lib_format)
+  template <typename U, typename CharT>
+  friend struct std::formatter;
+#endif
+
   size_type _stack_size;
   size_type _current_size;
   T* _stack;
@@ -394,6 +537,10 @@ private:
 /**
     Ridefinizione dell'operatore di stream, affinchè accetti in input un GenericStack<T>.
     Prima di utilizzarlo assicurarsi che per il tipo di dato T sia definito l'operatore di stream.
+    Ogni elemento è seguito da uno spazio, al termine viene scritto un fine riga e lo stream
+    viene svuotato (come con std::endl). Se lo stream usa la formattazione di default gli elementi
+    passano per il buffer di write_to, altrimenti vengono scritti uno alla volta così da
+    rispettare flag, larghezza e locale impostati dal chiamante.
     
     @param lo stream di output
     @param l'oggetto GenericStack da mandare in output.
@@ -402,13 +549,47 @@ private:
   */
 template <typename T>
 std::ostream &operator<<(std::ostream &os, const GenericStack<T> &stack) {
-    typename GenericStack<T>::const_iterator itr = stack.begin();
-    typename GenericStack<T>::const_iterator stack_end = stack.end();
-    for(; itr != stack_end; --itr){
-      os << *itr << " ";
+    const bool default_format = os.flags() == (std::ios_base::skipws | std::ios_base::dec)
+                                && os.width() == 0 && os.precision() <= 30
+                                && os.getloc() == std::locale::classic();
+    if(default_format){
+      char buffer[GenericStack<T>::_local_buffer_size];
+      stack._write(os, buffer, buffer + GenericStack<T>::_local_buffer_size, " ", true, "\n",
+                   static_cast<int>(os.precision()));
+    }else{
+      for(typename GenericStack<T>::size_type i = stack._current_size; i > 0; --i){
+        os << stack._stack[i] << " ";
+      }
+      os << '\n';
     }
-    os << std::endl; 
+    os.flush();
     return os;
 }
 
+#if defined(__cpp_lib_format)
+/**
+    Specializzazione di std::formatter per GenericStack<T>, disponibile solo se la libreria
+    standard supporta std::format (es. -std=c++20 con GCC 13 o superiore).
+    Le specifiche di formato vengono applicate a ciascun elemento, separati da uno spazio
+    e stampati dalla cima al fondo dello stack (es. std::format("{:.2f}", stack)).
+  */
+namespace std {
+template <typename T, typename CharT>
+struct formatter<GenericStack<T>, CharT> : formatter<T, CharT> {
+  template <typename FormatContext>
+  typename FormatContext::iterator format(const GenericStack<T> &stack, FormatContext &ctx) const {
+    typename FormatContext::iterator out = ctx.out();
+    for(typename GenericStack<T>::size_type i = stack._current_size; i > 0; --i){
+      out = formatter<T, CharT>::format(stack._stack[i], ctx);
+      if(i > 1){
+        *out++ = CharT(' ');
+      }
+      ctx.advance_to(out);
+    }
+    return out;
+  }
+};
+}
+#endif
+
 #endif
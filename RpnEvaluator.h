@@ -0,0 +1,378 @@
+#ifndef RPN_EVALUATOR_H
+#define RPN_EVALUATOR_H
+
+
+#include <charconv>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "BoundedStack.h"
+
+/**
+  @brief RpnEvaluator<T>
+
+  Classe che compila un'espressione in notazione polacca inversa (RPN) in bytecode
+  e la valuta su righe di input, una alla volta oppure a blocchi.
+
+  L'espressione è una sequenza di token separati da spazi:
+  - costanti numeriche di tipo T (es. 3, -2.5)
+  - variabili x0, x1, ... che fanno riferimento alle colonne della riga di input
+  - operatori binari + - * /
+  - operatore unario neg
+
+  La compilazione verifica che l'espressione sia ben formata e calcola la profondità massima
+  dello stack degli operandi. Lo stack degli operandi è fornito dal chiamante tramite un
+  BoundedStack<T> preallocato: la valutazione verifica una sola volta per chiamata che lo spazio
+  libero sia sufficiente, non esegue controlli sui limiti per operando, non alloca memoria e
+  non lancia eccezioni. Gli errori sono segnalati tramite valore di ritorno, come in BoundedStack.
+  Il bytecode non viene modificato dalla valutazione, per cui lo stesso RpnEvaluator può essere
+  condiviso tra più thread, purché ciascuno usi il proprio stack degli operandi.
+  Le sequenze "operando operatore" vengono fuse in una singola istruzione (superistruzione),
+  così da ridurre il numero di dispatch per espressione.
+  Le divisioni intere per zero non sono gestite, come per l'operatore / del tipo T.
+*/
+template <typename T>
+class RpnEvaluator {
+
+  static_assert(std::is_arithmetic<T>::value && !std::is_same<T, bool>::value,
+                "RpnEvaluator<T> richiede un tipo T aritmetico");
+
+public:
+
+  typedef unsigned int size_type;
+
+  /**
+    Costruttore della classe RpnEvaluator<T>: compila l'espressione in bytecode.
+
+    @param espressione in notazione polacca inversa
+
+    @throw std::invalid_argument L'eccezione è lanciata quando l'espressione contiene un token
+    non riconosciuto, quando un operatore non ha abbastanza operandi o quando l'espressione
+    non produce esattamente un risultato
+    @throw std::bad_alloc L'eccezione è lanciata quando l'allocazione di memoria per il bytecode
+    fallisce
+  */
+  explicit RpnEvaluator(const std::string &expression) : _variables(0), _max_depth(0) {
+    _compile(expression);
+  }
+
+  /**
+    Metodo per il ritorno del numero di colonne che la riga di input deve contenere.
+
+    @return indice massimo delle variabili usate + 1
+  */
+  size_type variables() const {
+    return _variables;
+  }
+
+  /**
+    Metodo per il ritorno del numero di istruzioni del bytecode, dopo la fusione.
+
+    @return numero di istruzioni
+  */
+  size_type instructions() const {
+    return static_cast<size_type>(_program.size());
+  }
+
+  /**
+    Metodo per il ritorno dello spazio libero che lo stack degli operandi deve avere per evaluate.
+
+    @return profondità massima raggiunta dallo stack durante la valutazione
+  */
+  size_type operand_stack_size() const {
+    return _max_depth;
+  }
+
+  /**
+    Metodo per il ritorno dello spazio libero che lo stack degli operandi deve avere per
+    evaluate_batch.
+
+    @return profondità massima moltiplicata per block_size
+  */
+  size_type batch_operand_stack_size() const {
+    return _max_depth * block_size;
+  }
+
+  /**
+    Metodo per la valutazione dell'espressione su una singola riga di input.
+    Gli operandi occupano le posizioni libere sopra la cima di operands, che al termine
+    contiene gli stessi elementi di prima della chiamata.
+
+    @param puntatore alla riga di input, con almeno variables() elementi
+    @param stack degli operandi, con almeno operand_stack_size() posizioni libere
+    @param reference all'oggetto in cui copiare il risultato dell'espressione
+    @return true se l'espressione è stata valutata, false se lo stack degli operandi non ha
+    abbastanza posizioni libere (result non viene modificato)
+  */
+  bool evaluate(const T *row, BoundedStack<T> &operands, T &result) const noexcept {
+    if(operands.size() - operands.current_stack_size() < _max_depth){
+      return false;
+    }
+
+    T *const base = operands.data() + operands.current_stack_size();
+    T *sp = base;
+    const Instruction *ip = _program.data();
+    const Instruction *const program_end = ip + _program.size();
+
+    //sp punta alla prima posizione libera, la cima dello stack è sp[-1]
+    for(; ip != program_end; ++ip){
+      switch(ip->op){
+        case PUSH_CONST: *sp++ = ip->value; break;
+        case PUSH_VAR:   *sp++ = row[ip->index]; break;
+        case ADD: --sp; sp[-1] += sp[0]; break;
+        case SUB: --sp; sp[-1] -= sp[0]; break;
+        case MUL: --sp; sp[-1] *= sp[0]; break;
+        case DIV: --sp; sp[-1] /= sp[0]; break;
+        case NEG: sp[-1] = -sp[-1]; break;
+        case ADD_CONST: sp[-1] += ip->value; break;
+        case SUB_CONST: sp[-1] -= ip->value; break;
+        case MUL_CONST: sp[-1] *= ip->value; break;
+        case DIV_CONST: sp[-1] /= ip->value; break;
+        case ADD_VAR: sp[-1] += row[ip->index]; break;
+        case SUB_VAR: sp[-1] -= row[ip->index]; break;
+        case MUL_VAR: sp[-1] *= row[ip->index]; break;
+        case DIV_VAR: sp[-1] /= row[ip->index]; break;
+      }
+    }
+    result = base[0];
+    return true;
+  }
+
+  /**
+    Metodo per la valutazione dell'espressione su più righe di input.
+    Le righe vengono elaborate a blocchi di block_size: ogni istruzione è decodificata una
+    sola volta per blocco e applicata a tutte le righe del blocco.
+
+    @param puntatore alla prima riga di input, le righe sono memorizzate consecutivamente
+    @param numero di righe da valutare
+    @param distanza in elementi tra l'inizio di due righe consecutive (almeno variables())
+    @param puntatore all'array dei risultati, con almeno row_count elementi
+    @param stack degli operandi, con almeno batch_operand_stack_size() posizioni libere
+    @return true se le righe sono state valutate, false se row_stride è minore di variables()
+    o se lo stack degli operandi non ha abbastanza posizioni libere (results non viene modificato)
+  */
+  bool evaluate_batch(const T *rows, const size_type row_count, const size_type row_stride,
+                      T *results, BoundedStack<T> &operands) const noexcept {
+    if(row_stride < _variables
+       || operands.size() - operands.current_stack_size() < batch_operand_stack_size()){
+      return false;
+    }
+
+    T *const base = operands.data() + operands.current_stack_size();
+    const Instruction *const program_begin = _program.data();
+    const Instruction *const program_end = program_begin + _program.size();
+
+    //Indice in std::size_t: first + block_size non può superare il limite di size_type
+    for(std::size_t first = 0; first < row_count; first += block_size){
+      const size_type count = static_cast<size_type>(
+        (row_count - first < block_size) ? row_count - first : block_size);
+      const T *block_rows = rows + static_cast<std::size_t>(first) * row_stride;
+      //sp punta al primo slot libero, ogni slot contiene block_size operandi
+      T *sp = base;
+
+      for(const Instruction *ip = program_begin; ip != program_end; ++ip){
+        //Copie locali: le scritture sugli operandi non possono modificare l'istruzione corrente
+        const T value = ip->value;
+        const T *column = block_rows + ip->index;
+        T *top;
+        switch(ip->op){
+          case PUSH_CONST:
+            for(size_type r = 0; r < count; ++r) sp[r] = value;
+            sp += block_size;
+            break;
+          case PUSH_VAR:
+            for(size_type r = 0; r < count; ++r) sp[r] = column[static_cast<std::size_t>(r) * row_stride];
+            sp += block_size;
+            break;
+          case ADD:
+            sp -= block_size; top = sp - block_size;
+            for(size_type r = 0; r < count; ++r) top[r] += sp[r];
+            break;
+          case SUB:
+            sp -= block_size; top = sp - block_size;
+            for(size_type r = 0; r < count; ++r) top[r] -= sp[r];
+            break;
+          case MUL:
+            sp -= block_size; top = sp - block_size;
+            for(size_type r = 0; r < count; ++r) top[r] *= sp[r];
+            break;
+          case DIV:
+            sp -= block_size; top = sp - block_size;
+            for(size_type r = 0; r < count; ++r) top[r] /= sp[r];
+            break;
+          case NEG:
+            top = sp - block_size;
+            for(size_type r = 0; r < count; ++r) top[r] = -top[r];
+            break;
+          case ADD_CONST:
+            top = sp - block_size;
+            for(size_type r = 0; r < count; ++r) top[r] += value;
+            break;
+          case SUB_CONST:
+            top = sp - block_size;
+            for(size_type r = 0; r < count; ++r) top[r] -= value;
+            break;
+          case MUL_CONST:
+            top = sp - block_size;
+            for(size_type r = 0; r < count; ++r) top[r] *= value;
+            break;
+          case DIV_CONST:
+            top = sp - block_size;
+            for(size_type r = 0; r < count; ++r) top[r] /= value;
+            break;
+          case ADD_VAR:
+            top = sp - block_size;
+            for(size_type r = 0; r < count; ++r) top[r] += column[static_cast<std::size_t>(r) * row_stride];
+            break;
+          case SUB_VAR:
+            top = sp - block_size;
+            for(size_type r = 0; r < count; ++r) top[r] -= column[static_cast<std::size_t>(r) * row_stride];
+            break;
+          case MUL_VAR:
+            top = sp - block_size;
+            for(size_type r = 0; r < count; ++r) top[r] *= column[static_cast<std::size_t>(r) * row_stride];
+            break;
+          case DIV_VAR:
+            top = sp - block_size;
+            for(size_type r = 0; r < count; ++r) top[r] /= column[static_cast<std::size_t>(r) * row_stride];
+            break;
+        }
+      }
+
+      for(size_type r = 0; r < count; ++r){
+        results[first + r] = base[r];
+      }
+    }
+    return true;
+  }
+
+  //Numero di righe elaborate insieme da evaluate_batch
+  static constexpr size_type block_size = 64;
+
+private:
+
+  enum Opcode {
+    PUSH_CONST, PUSH_VAR,
+    ADD, SUB, MUL, DIV, NEG,
+    //Superistruzioni: operatore binario con operando costante o variabile
+    ADD_CONST, SUB_CONST, MUL_CONST, DIV_CONST,
+    ADD_VAR, SUB_VAR, MUL_VAR, DIV_VAR
+  };
+
+  struct Instruction {
+    Opcode op;
+    size_type index;
+    T value;
+  };
+
+  //Traduce l'espressione in bytecode, fondendo le istruzioni quando possibile
+  void _compile(const std::string &expression) {
+    std::istringstream tokens(expression);
+    std::string token;
+    size_type depth = 0;
+
+    while(tokens >> token){
+      Opcode binary;
+      if(token == "+"){
+        binary = ADD;
+      }else if(token == "-"){
+        binary = SUB;
+      }else if(token == "*"){
+        binary = MUL;
+      }else if(token == "/"){
+        binary = DIV;
+      }else if(token == "neg"){
+        if(depth < 1){
+          throw std::invalid_argument("Missing operand for neg.");
+        }
+        //La negazione di una costante viene calcolata in fase di compilazione
+        if(!_program.empty() && _program.back().op == PUSH_CONST){
+          _program.back().value = -_program.back().value;
+        }else{
+          _emit(NEG, 0, T());
+        }
+        continue;
+      }else{
+        _emit_operand(token);
+        ++depth;
+        continue;
+      }
+
+      if(depth < 2){
+        throw std::invalid_argument("Missing operand for " + token + ".");
+      }
+      --depth;
+
+      //Se l'operando destro è stato appena inserito l'operatore lo consuma direttamente
+      Instruction &last = _program.back();
+      if(last.op == PUSH_CONST){
+        last.op = static_cast<Opcode>(ADD_CONST + (binary - ADD));
+      }else if(last.op == PUSH_VAR){
+        last.op = static_cast<Opcode>(ADD_VAR + (binary - ADD));
+      }else{
+        _emit(binary, 0, T());
+      }
+    }
+
+    if(depth != 1){
+      throw std::invalid_argument("Expression must produce exactly one value.");
+    }
+
+    //Profondità massima raggiunta dal bytecode, dopo la fusione
+    depth = 0;
+    for(const Instruction &ins : _program){
+      if(ins.op == PUSH_CONST || ins.op == PUSH_VAR){
+        ++depth;
+        if(depth > _max_depth){
+          _max_depth = depth;
+        }
+      }else if(ins.op >= ADD && ins.op <= DIV){
+        --depth;
+      }
+    }
+  }
+
+  //Traduce una costante o una variabile in un'istruzione di inserimento
+  void _emit_operand(const std::string &token) {
+    const char *first = token.data();
+    const char *last = first + token.size();
+
+    if(token.size() > 1 && token[0] == 'x'){
+      size_type index = 0;
+      const std::from_chars_result res = std::from_chars(first + 1, last, index);
+      //L'indice massimo renderebbe variables() non rappresentabile
+      if(res.ec != std::errc() || res.ptr != last || index == std::numeric_limits<size_type>::max()){
+        throw std::invalid_argument("Invalid variable " + token + ".");
+      }
+      if(index + 1 > _variables){
+        _variables = index + 1;
+      }
+      _emit(PUSH_VAR, index, T());
+      return;
+    }
+
+    T value = T();
+    const std::from_chars_result res = std::from_chars(first, last, value);
+    if(res.ec != std::errc() || res.ptr != last){
+      throw std::invalid_argument("Invalid token " + token + ".");
+    }
+    _emit(PUSH_CONST, 0, value);
+  }
+
+  void _emit(const Opcode op, const size_type index, const T value) {
+    Instruction ins;
+    ins.op = op;
+    ins.index = index;
+    ins.value = value;
+    _program.push_back(ins);
+  }
+
+  std::vector<Instruction> _program;
+  size_type _variables;
+  size_type _max_depth;
+  };
+
+#endif
@@ -0,0 +1,205 @@
+/**
+@file benchmark.cpp
+
+@brief confronto tra RpnEvaluator e una valutazione RPN basata su GenericStack::push/pop,
+       e tra la scrittura in blocco (write_to, operator<<) e la scrittura elemento per elemento
+**/
+#include <iostream>
+#include <streambuf>
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "GenericStack.h"
+#include "BoundedStack.h"
+#include "RpnEvaluator.h"
+
+/**
+  @brief Token di un'espressione RPN già suddivisa, usato dalla valutazione naive
+
+*/
+struct naiveToken {
+  char op;          // 'c' costante, 'x' variabile, altrimenti l'operatore
+  unsigned int index;
+  double value;
+};
+
+/**
+  Suddivide l'espressione in token una sola volta, così che il confronto misuri
+  solo il costo della valutazione.
+*/
+std::vector<naiveToken> tokenize(const std::string &expression) {
+  std::vector<naiveToken> tokens;
+  std::istringstream in(expression);
+  std::string text;
+  while(in >> text){
+    naiveToken token = {'c', 0, 0.0};
+    if(text == "+" || text == "-" || text == "*" || text == "/"){
+      token.op = text[0];
+    }else if(text == "neg"){
+      token.op = 'n';
+    }else if(text[0] == 'x'){
+      token.op = 'x';
+      token.index = std::stoul(text.substr(1));
+    }else{
+      token.value = std::stod(text);
+    }
+    tokens.push_back(token);
+  }
+  return tokens;
+}
+
+/**
+  Valutazione naive: ogni operando passa per GenericStack::push/pop, con i relativi
+  controlli sui limiti.
+*/
+double naive_evaluate(GenericStack<double> &stack, const std::vector<naiveToken> &tokens, const double *row) {
+  stack.flush();
+  for(const naiveToken &token : tokens){
+    switch(token.op){
+      case 'c': stack.push(token.value); break;
+      case 'x': stack.push(row[token.index]); break;
+      case 'n': stack.push(-stack.pop()); break;
+      default: {
+        const double rhs = stack.pop();
+        const double lhs = stack.pop();
+        switch(token.op){
+          case '+': stack.push(lhs + rhs); break;
+          case '-': stack.push(lhs - rhs); break;
+          case '*': stack.push(lhs * rhs); break;
+          default:  stack.push(lhs / rhs); break;
+        }
+      }
+    }
+  }
+  return stack.pop();
+}
+
+/**
+  @brief Stream buffer che scarta tutto ciò che riceve, così da misurare solo la formattazione
+
+*/
+struct nullBuffer : std::streambuf {
+protected:
+  int_type overflow(int_type ch) override {
+    return traits_type::not_eof(ch);
+  }
+
+  std::streamsize xsputn(const char *, std::streamsize count) override {
+    return count;
+  }
+};
+
+/**
+  Scrittura elemento per elemento tramite const_iterator e std::endl, come faceva
+  l'operatore di stream prima dell'introduzione di write_to.
+*/
+template <typename T>
+void legacy_output(std::ostream &os, const GenericStack<T> &stack) {
+  typename GenericStack<T>::const_iterator itr = stack.begin();
+  typename GenericStack<T>::const_iterator stack_end = stack.end();
+  for(; itr != stack_end; --itr){
+    os << *itr << " ";
+  }
+  os << std::endl;
+}
+
+/**
+  Confronta la scrittura elemento per elemento con operator<< e write_to su uno stack
+  di 10M elementi.
+*/
+template <typename T>
+void benchmark_output(const char *type_name) {
+  typedef std::chrono::steady_clock clock;
+  const unsigned int elements = 10000000;
+
+  GenericStack<T> stack(elements);
+  for(unsigned int i = 0; i < elements; ++i){
+    stack.push(static_cast<T>(i * 1.37));
+  }
+  nullBuffer discard;
+  std::ostream os(&discard);
+  std::string buffer;
+
+  clock::time_point start = clock::now();
+  legacy_output(os, stack);
+  const double legacy_time = std::chrono::duration<double>(clock::now() - start).count();
+
+  start = clock::now();
+  os << stack;
+  const double stream_time = std::chrono::duration<double>(clock::now() - start).count();
+
+  start = clock::now();
+  stack.write_to(os, " ", "\n", false, buffer);
+  const double write_time = std::chrono::duration<double>(clock::now() - start).count();
+
+  std::cout << type_name << ": elemento per elemento " << legacy_time << " s, operator<< "
+            << stream_time << " s (x" << legacy_time / stream_time << "), write_to "
+            << write_time << " s (x" << legacy_time / write_time << ")" << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+  const std::string expression = "x0 2 + x1 x0 - * x2 3 * x3 / neg + 0.5 *";
+  const unsigned int columns = 4;
+  const unsigned int rows = 4000000;
+
+  std::vector<double> input(static_cast<std::size_t>(rows) * columns);
+  for(std::size_t i = 0; i < input.size(); ++i){
+    input[i] = (i % 97) * 0.25 + 1.0;
+  }
+  std::vector<double> results(rows);
+  double checksum_naive = 0;
+  double checksum_single = 0;
+  double checksum_batch = 0;
+
+  typedef std::chrono::steady_clock clock;
+
+  //GenericStack::push/pop
+  const std::vector<naiveToken> tokens = tokenize(expression);
+  GenericStack<double> stack(static_cast<GenericStack<double>::size_type>(tokens.size()));
+  clock::time_point start = clock::now();
+  for(unsigned int r = 0; r < rows; ++r){
+    checksum_naive += naive_evaluate(stack, tokens, &input[static_cast<std::size_t>(r) * columns]);
+  }
+  const double naive_time = std::chrono::duration<double>(clock::now() - start).count();
+
+  //RpnEvaluator, una riga alla volta
+  const RpnEvaluator<double> evaluator(expression);
+  std::vector<double> operand_storage(evaluator.batch_operand_stack_size());
+  BoundedStack<double> operands(operand_storage.data(), evaluator.batch_operand_stack_size());
+  double result = 0;
+  start = clock::now();
+  for(unsigned int r = 0; r < rows; ++r){
+    evaluator.evaluate(&input[static_cast<std::size_t>(r) * columns], operands, result);
+    checksum_single += result;
+  }
+  const double single_time = std::chrono::duration<double>(clock::now() - start).count();
+
+  //RpnEvaluator, a blocchi
+  start = clock::now();
+  evaluator.evaluate_batch(input.data(), rows, columns, results.data(), operands);
+  for(unsigned int r = 0; r < rows; ++r){
+    checksum_batch += results[r];
+  }
+  const double batch_time = std::chrono::duration<double>(clock::now() - start).count();
+
+  std::cout << "espressione: " << expression << std::endl;
+  std::cout << "righe: " << rows << ", istruzioni: " << evaluator.instructions()
+            << " (token: " << tokens.size() << ")" << std::endl;
+  std::cout << "GenericStack push/pop:        " << naive_time * 1e9 / rows << " ns/riga" << std::endl;
+  std::cout << "RpnEvaluator::evaluate:       " << single_time * 1e9 / rows << " ns/riga (x"
+            << naive_time / single_time << ")" << std::endl;
+  std::cout << "RpnEvaluator::evaluate_batch: " << batch_time * 1e9 / rows << " ns/riga (x"
+            << naive_time / batch_time << ")" << std::endl;
+
+  std::cout << std::endl << "scrittura di 10M elementi:" << std::endl;
+  benchmark_output<int>("int   ");
+  benchmark_output<long>("long  ");
+  benchmark_output<double>("double");
+
+  if(checksum_naive != checksum_single || checksum_naive != checksum_batch){
+    std::cout << "risultati diversi tra le valutazioni" << std::endl;
+    return 1;
+  }
+  return 0;
+}
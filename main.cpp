@@ -5,7 +5,48 @@
 **/
 #include <iostream>
 #include "GenericStack.h" // dbuffer<int>
+#include "BoundedStack.h"
+#include "RpnEvaluator.h"
 #include <cassert>   // assert
+#include <sstream>   // std::ostringstream
+#include <string>
+#include <vector>
+#include <cstdlib>   // std::malloc, std::free
+#include <new>       // std::bad_alloc
+
+/**
+  Contatore delle allocazioni sullo heap, incrementato dalla ridefinizione globale di
+  operator new. Permette di verificare che BoundedStack<T> non allochi memoria.
+*/
+static unsigned long heap_allocations = 0;
+
+void* operator new(std::size_t size) {
+  ++heap_allocations;
+  if(void *ptr = std::malloc(size == 0 ? 1 : size)){
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+  return ::operator new(size);
+}
+
+void operator delete(void *ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
 
 /**
   @brief Funtore di ricerca di uno specifico carattere
@@ -269,10 +310,342 @@ void test_metodi_iteratori(){
     //*gs_itr = 45.5
 }
 
+/**
+ * test_metodi_output
+ * 
+  @brief test della scrittura in blocco dello stack tramite write_to
+
+*/
+void test_metodi_output(){
+    std::cout<<"******** Test scrittura in blocco della classe GenericStack *******"<<std::endl;
+    GenericStack<int> gs(4);
+    gs.push(1);
+    gs.push(-22);
+    gs.push(333);
+
+    //write_to produce lo stesso ordine dell'operatore di stream (dalla cima al fondo)
+    std::ostringstream out;
+    std::string buffer;
+    gs.write_to(out, " ", "\n", false, buffer);
+    assert(out.str() == "333 -22 1\n");
+    //il buffer viene svuotato ma mantiene la sua capacità per le chiamate successive
+    assert(buffer.empty());
+    std::cout<<"-------- contenuto dello stack scritto con write_to "<<std::endl;
+    std::cout << "         ";
+    gs.write_to(std::cout, " ", "\n", false, buffer);
+
+    //separatore e terminatore a scelta del chiamante
+    out.str("");
+    gs.write_to(out, ",", "]", false, buffer);
+    assert(out.str() == "333,-22,1]");
+
+    //un separatore di tipo std::string non viene scambiato per il buffer né svuotato
+    const std::string comma = ", ";
+    std::string separator = comma;
+    out.str("");
+    gs.write_to(out, separator);
+    assert(out.str() == "333, -22, 1\n");
+    assert(separator == comma);
+
+    //senza buffer del chiamante, come per l'operatore di stream, non si alloca memoria
+    std::ostringstream preallocated(std::string(256, ' '));
+    preallocated.seekp(0);
+    const unsigned long allocations = heap_allocations;
+    gs.write_to(preallocated, ";");
+    preallocated << gs;
+    assert(heap_allocations == allocations);
+    const std::string written = "333;-22;1\n333 -22 1 \n";
+    assert(preallocated.str().compare(0, written.size(), written) == 0);
+
+    //stack vuoto: viene scritto solo il terminatore
+    GenericStack<double> gs_empty(3);
+    out.str("");
+    gs_empty.write_to(out);
+    assert(out.str() == "\n");
+
+    //i floating point sono scritti nella rappresentazione più breve che ne consente la rilettura
+    GenericStack<double> gs_double(2);
+    gs_double.push(0.1);
+    gs_double.push(57.32113);
+    out.str("");
+    gs_double.write_to(out, " ", "", true);
+    assert(out.str() == "57.32113 0.1");
+
+    //i char sono scritti come caratteri, gli altri tipi tramite il loro operatore di stream
+    GenericStack<char> gs_char(2);
+    gs_char.push('K');
+    gs_char.push('O');
+    out.str("");
+    gs_char.write_to(out, "", "\n", false, buffer);
+    assert(out.str() == "OK\n");
+
+    //l'operatore di stream usa lo stesso buffer ma mantiene il formato originale
+    out.str("");
+    out << gs_double;
+    assert(out.str() == "57.3211 0.1 \n");
+    out.str("");
+    out << gs_char;
+    assert(out.str() == "O K \n");
+    //con una formattazione non di default gli elementi sono scritti uno alla volta
+    out.str("");
+    out << std::hex << gs;
+    assert(out.str() == "14d ffffffea 1 \n");
+    out << std::dec;
+
+    GenericStack<std::string> gs_string(2);
+    gs_string.push("mondo");
+    gs_string.push("ciao");
+    out.str("");
+    gs_string.write_to(out, " ", "\n", false, buffer);
+    assert(out.str() == "ciao mondo\n");
+
+    //stack più grande dei buffer: il contenuto viene scritto a blocchi senza perdite
+    GenericStack<long> gs_long(20000);
+    std::ostringstream expected;
+    std::ostringstream expected_long_separator;
+    const std::string long_separator(5000, '|');
+    for(long i = 0; i < 20000; ++i){
+        gs_long.push(i * 7919 - 1000000);
+    }
+    GenericStack<long>::const_iterator itr = gs_long.begin();
+    GenericStack<long>::const_iterator stack_end = gs_long.end();
+    for(bool first = true; itr != stack_end; --itr, first = false){
+        if(!first){
+            expected << ' ';
+            expected_long_separator << long_separator;
+        }
+        expected << *itr;
+        expected_long_separator << *itr;
+    }
+    out.str("");
+    gs_long.write_to(out, " ", "", false, buffer);
+    assert(out.str() == expected.str());
+    out.str("");
+    gs_long.write_to(out, " ", "");
+    assert(out.str() == expected.str());
+    //separatore più grande del buffer locale
+    out.str("");
+    gs_long.write_to(out, long_separator, "");
+    assert(out.str() == expected_long_separator.str());
+
+#if defined(__cpp_lib_format)
+    //std::format applica le specifiche di formato a ciascun elemento
+    assert(std::format("{}", gs) == "333 -22 1");
+    assert(std::format("{:.2f}", gs_double) == "57.32 0.10");
+    assert(std::format("[{}]", gs_empty) == "[]");
+#endif
+    std::cout << std::endl;
+    std::cout << std::endl;
+    std::cout << std::endl;
+}
+
+/**
+ * test_metodi_bounded
+ * 
+  @brief test della classe BoundedStack: nessuna allocazione e nessuna eccezione
+
+*/
+void test_metodi_bounded(){
+    std::cout<<"******** Test metodi della classe BoundedStack *******"<<std::endl;
+    int storage[4];
+    double external[3];
+    int value = 0;
+
+    //il contatore registra le allocazioni di GenericStack<T>
+    unsigned long allocations = heap_allocations;
+    {
+        GenericStack<int> gs(4);
+    }
+    assert(heap_allocations > allocations);
+
+    allocations = heap_allocations;
+    //Tutte le operazioni sono noexcept: un'eccezione termina il programma
+    {
+        static_assert(noexcept(BoundedStack<int>(storage)), "il costruttore da array deve essere noexcept");
+        static_assert(noexcept(BoundedStack<double>(external, 3)), "il costruttore da puntatore deve essere noexcept");
+        BoundedStack<int> bs(storage);
+        static_assert(noexcept(bs.push(value)), "push deve essere noexcept");
+        static_assert(noexcept(bs.pop(value)), "pop deve essere noexcept");
+        static_assert(noexcept(bs.pop()), "pop deve essere noexcept");
+        static_assert(noexcept(bs.top()), "top deve essere noexcept");
+        static_assert(noexcept(bs.flush()), "flush deve essere noexcept");
+        static_assert(noexcept(bs.empty()), "empty deve essere noexcept");
+        static_assert(noexcept(bs.full()), "full deve essere noexcept");
+        static_assert(noexcept(bs.size()), "size deve essere noexcept");
+        static_assert(noexcept(bs.current_stack_size()), "current_stack_size deve essere noexcept");
+        assert(bs.size() == 4);
+        assert(bs.empty());
+
+        bool inserted = true;
+        for(int i = 1; i <= 4; ++i){
+            inserted = bs.push(i) && inserted;
+        }
+        assert(inserted);
+        assert(bs.full());
+        //lo stack pieno rifiuta l'inserimento senza lanciare eccezioni
+        inserted = bs.push(5);
+        assert(!inserted);
+        assert(bs.current_stack_size() == 4);
+        assert(*bs.top() == 4);
+
+        bool removed = bs.pop(value);
+        assert(removed && value == 4);
+        removed = bs.pop();
+        assert(removed && *bs.top() == 2);
+        bs.pop();
+        removed = bs.pop(value);
+        assert(removed && value == 1);
+        //lo stack vuoto rifiuta il prelievo senza lanciare eccezioni
+        removed = bs.pop(value);
+        assert(!removed);
+        removed = bs.pop();
+        assert(!removed);
+        assert(bs.top() == nullptr);
+
+        //lo stack lavora direttamente sulla memoria del chiamante
+        bs.push(7);
+        assert(storage[0] == 7);
+        bs.flush();
+        assert(bs.empty());
+
+        BoundedStack<double> bs_ptr(external, 3);
+        bs_ptr.push(1.5);
+        assert(bs_ptr.current_stack_size() == 1 && external[0] == 1.5);
+        BoundedStack<double> bs_null(nullptr, 10);
+        inserted = bs_null.push(1.5);
+        assert(bs_null.size() == 0 && !inserted);
+    }
+    assert(heap_allocations == allocations);
+    std::cout<<"-------- nessuna allocazione sullo heap durante l'uso di BoundedStack "<<std::endl;
+    std::cout << std::endl;
+    std::cout << std::endl;
+    std::cout << std::endl;
+}
+
+/**
+ * test_metodi_rpn
+ * 
+  @brief test della classe RpnEvaluator: compilazione, valutazione singola e a blocchi
+
+*/
+void test_metodi_rpn(){
+    std::cout<<"******** Test metodi della classe RpnEvaluator *******"<<std::endl;
+    //stack degli operandi preallocato dal chiamante
+    double operand_storage[8];
+    BoundedStack<double> operands(operand_storage);
+
+    //(x0 + 2) * (x1 - x0) / 4
+    RpnEvaluator<double> expr("x0 2 + x1 x0 - * 4 /");
+    assert(expr.variables() == 2);
+    //le sequenze "operando operatore" vengono fuse: 2 + e x0 - e 4 /
+    assert(expr.instructions() == 6);
+    assert(expr.operand_stack_size() == 2);
+
+    const double row[] = {3.0, 7.0};
+    double result = 0.0;
+    bool evaluated = expr.evaluate(row, operands, result);
+    assert(evaluated && result == 5.0);
+    std::cout<<"-------- valutazione di x0 2 + x1 x0 - * 4 / con x0 = 3, x1 = 7 "<<std::endl;
+    std::cout << "         " << result << std::endl;
+
+    //il programma compilato è di sola lettura e può essere condiviso, ad esempio tra thread,
+    //purché ognuno usi il proprio stack degli operandi
+    const RpnEvaluator<double> &shared = expr;
+    double other_storage[2];
+    BoundedStack<double> other_operands(other_storage);
+    result = 0.0;
+    evaluated = shared.evaluate(row, other_operands, result);
+    assert(evaluated && result == 5.0);
+
+    //gli operandi usano solo le posizioni libere: gli elementi già presenti non cambiano
+    operands.push(-1.0);
+    result = 0.0;
+    evaluated = expr.evaluate(row, operands, result);
+    assert(evaluated && result == 5.0);
+    assert(operands.current_stack_size() == 1 && *operands.top() == -1.0);
+    operands.flush();
+
+    //uno stack degli operandi troppo piccolo viene rifiutato, anche con NDEBUG
+    double small_storage[1];
+    BoundedStack<double> small_operands(small_storage);
+    result = -3.0;
+    evaluated = expr.evaluate(row, small_operands, result);
+    assert(!evaluated && result == -3.0);
+    other_operands.push(1.0);
+    evaluated = expr.evaluate(row, other_operands, result);
+    assert(!evaluated && result == -3.0);
+
+    //la negazione di una costante viene calcolata in fase di compilazione
+    int int_storage[4];
+    BoundedStack<int> int_operands(int_storage);
+    int int_result = 0;
+    RpnEvaluator<int> expr_neg("x0 3 neg - neg");
+    const int row_int[] = {4};
+    assert(expr_neg.instructions() == 3);
+    evaluated = expr_neg.evaluate(row_int, int_operands, int_result);
+    assert(evaluated && int_result == -7);
+
+    RpnEvaluator<int> expr_const("42");
+    assert(expr_const.variables() == 0);
+    evaluated = expr_const.evaluate(nullptr, int_operands, int_result);
+    assert(evaluated && int_result == 42);
+
+    //la valutazione a blocchi coincide con quella riga per riga, anche oltre block_size
+    const unsigned int rows = RpnEvaluator<double>::block_size * 2 + 5;
+    const unsigned int stride = 3;
+    std::vector<double> input(rows * stride);
+    std::vector<double> results(rows);
+    for(unsigned int i = 0; i < input.size(); ++i){
+        input[i] = i * 0.5 + 1.0;
+    }
+    RpnEvaluator<double> expr_batch("x0 x2 * x1 neg x0 - / 1.5 -");
+    std::vector<double> batch_storage(expr_batch.batch_operand_stack_size());
+    BoundedStack<double> batch_operands(batch_storage.data(), expr_batch.batch_operand_stack_size());
+    evaluated = expr_batch.evaluate_batch(input.data(), rows, stride, results.data(), batch_operands);
+    assert(evaluated);
+    for(unsigned int r = 0; r < rows; ++r){
+        evaluated = expr_batch.evaluate(&input[r * stride], operands, result);
+        assert(evaluated && results[r] == result);
+    }
+
+    //stack degli operandi insufficiente o righe più corte di variables(): nessuna scrittura
+    std::vector<double> untouched(rows, -3.0);
+    evaluated = expr_batch.evaluate_batch(input.data(), rows, stride, untouched.data(), operands);
+    assert(!evaluated);
+    evaluated = expr_batch.evaluate_batch(input.data(), rows, 2, untouched.data(), batch_operands);
+    assert(!evaluated);
+    assert(untouched == std::vector<double>(rows, -3.0));
+
+    //x4294967295 renderebbe variables() non rappresentabile
+    const char *invalid[] = {"", "x0 +", "1 2", "x0 y1 +", "x 1 +", "neg", "1 2 3 + foo",
+                             "x4294967295", "x4294967296"};
+    for(const char *text : invalid){
+        bool rejected = false;
+        try{
+            RpnEvaluator<double> bad(text);
+        }catch(const std::invalid_argument& ex){
+            rejected = true;
+        }
+        assert(rejected);
+    }
+    try{
+        RpnEvaluator<double> bad("1 2 + *");
+    }catch(const std::invalid_argument& ex){
+        std::cout<<"-------- Se l'espressione non è ben formata viene generato un errore std::invalid_argument"<<std::endl;
+        std::cout << "         " << ex.what() <<std::endl;
+    }
+    std::cout << std::endl;
+    std::cout << std::endl;
+    std::cout << std::endl;
+}
+
 int main(int argc, char *argv[]) {
     test_metodi_fondamentali();
     test_metodi_specifici();
     test_metodi_iteratori();
+    test_metodi_output();
+    test_metodi_bounded();
+    test_metodi_rpn();
 
     const charEqlTarget cel('X');
     const charEqlTarget cel2('D');